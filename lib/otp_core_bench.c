@@ -0,0 +1,278 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "otp_pool.h"
+#include "otp_totp.h"
+
+// Harnais façon Google Benchmark : chaque benchmark est relancé avec un nombre
+// d'itérations croissant jusqu'à dépasser min_time, puis le temps par itération
+// (horloge murale et CPU) est affiché.
+
+struct bench_state {
+    long iterations;
+    long arg;
+    double wall_ns;
+    double cpu_ns;
+    struct timespec wall_start, cpu_start;
+};
+
+struct bench {
+    const char *name;
+    void (*fn)(struct bench_state *st);
+    long arg; // 0 : pas d'argument
+};
+
+static volatile unsigned int bench_sink;
+
+static double ts_ns(const struct timespec *ts) {
+    return ts->tv_sec * 1e9 + ts->tv_nsec;
+}
+
+// à appeler après la mise en place, juste avant la boucle mesurée
+static void bench_start(struct bench_state *st) {
+    clock_gettime(CLOCK_MONOTONIC, &st->wall_start);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &st->cpu_start);
+}
+
+// à appeler juste après la boucle mesurée, avant le nettoyage
+static void bench_stop(struct bench_state *st) {
+    struct timespec wall, cpu;
+
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+    st->wall_ns = ts_ns(&wall) - ts_ns(&st->wall_start);
+    st->cpu_ns = ts_ns(&cpu) - ts_ns(&st->cpu_start);
+}
+
+static void pool_fill(struct otp_pool *pool, long n) {
+    char pw[32];
+    long i;
+
+    for (i = 0; i < n; i++) {
+        snprintf(pw, sizeof(pw), "bench%ld", i);
+        if (otp_pool_add(pool, pw) < 0) {
+            fprintf(stderr, "otp_pool_add: mémoire insuffisante\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static void pool_teardown(struct otp_pool *pool) {
+    otp_pool_clear(pool);
+    mutex_destroy(&pool->list_mutex);
+}
+
+static void BM_PoolAdd(struct bench_state *st) {
+    struct otp_pool pool;
+    long i;
+
+    otp_pool_init(&pool);
+    pool_fill(&pool, st->arg);
+
+    bench_start(st);
+    for (i = 0; i < st->iterations; i++)
+        otp_pool_add(&pool, "added");
+    bench_stop(st);
+
+    pool_teardown(&pool);
+}
+
+static void BM_PoolPick(struct bench_state *st) {
+    struct otp_pool pool;
+    char buf[64];
+    long i;
+
+    otp_pool_init(&pool);
+    pool_fill(&pool, st->arg);
+
+    bench_start(st);
+    for (i = 0; i < st->iterations; i++)
+        bench_sink += otp_pool_pick(&pool, buf, sizeof(buf));
+    bench_stop(st);
+
+    pool_teardown(&pool);
+}
+
+// tirage sans verrou depuis une session réservant le pool (au plus OTP_SESSION_MAX)
+static void BM_SessionPick(struct bench_state *st) {
+    struct otp_pool pool;
+    struct otp_session session;
+    char buf[64];
+    long i;
+
+    otp_pool_init(&pool);
+    pool_fill(&pool, st->arg);
+    otp_session_init(&session, &pool);
+    otp_session_reserve(&session, st->arg);
+
+    bench_start(st);
+    for (i = 0; i < st->iterations; i++)
+        bench_sink += otp_session_pick(&session, buf, sizeof(buf));
+    bench_stop(st);
+
+    otp_session_release(&session);
+    pool_teardown(&pool);
+}
+
+static void BM_PoolList(struct bench_state *st) {
+    struct otp_pool pool;
+    char buf[OTP_LIST_BUF_SIZE];
+    long i;
+
+    otp_pool_init(&pool);
+    pool_fill(&pool, st->arg);
+
+    bench_start(st);
+    for (i = 0; i < st->iterations; i++)
+        bench_sink += otp_pool_list(&pool, buf, sizeof(buf));
+    bench_stop(st);
+
+    pool_teardown(&pool);
+}
+
+// pire cas de OTP_IOC_DEL : la dernière entrée, ré-ajoutée aussitôt en fin de liste
+static void BM_PoolDelTail(struct bench_state *st) {
+    struct otp_pool pool;
+    char pw[32];
+    long i;
+
+    otp_pool_init(&pool);
+    pool_fill(&pool, st->arg);
+    snprintf(pw, sizeof(pw), "bench%ld", st->arg - 1);
+
+    bench_start(st);
+    for (i = 0; i < st->iterations; i++) {
+        bench_sink += otp_pool_del(&pool, pw);
+        otp_pool_add(&pool, pw);
+    }
+    bench_stop(st);
+
+    pool_teardown(&pool);
+}
+
+static void BM_TruncateToOtp(struct bench_state *st) {
+    unsigned char digest[SHA1_DIGEST_SIZE];
+    long i;
+
+    get_random_bytes(digest, sizeof(digest));
+
+    bench_start(st);
+    for (i = 0; i < st->iterations; i++) {
+        digest[SHA1_DIGEST_SIZE - 1] = (unsigned char)i;
+        bench_sink += truncate_to_otp(digest, SHA1_DIGEST_SIZE);
+    }
+    bench_stop(st);
+}
+
+static void BM_HmacOtp(struct bench_state *st) {
+    static const char key[] = "12345678901234567890";
+    unsigned int otp = 0;
+    u64 slot;
+    long i;
+
+    bench_start(st);
+    for (i = 0; i < st->iterations; i++) {
+        slot = i;
+        timeotp_hmac_otp(key, sizeof(key) - 1, (u8 *)&slot, sizeof(slot), &otp);
+        bench_sink += otp;
+    }
+    bench_stop(st);
+}
+
+static void BM_GenerateTimeOtp(struct bench_state *st) {
+    char buf[64];
+    long i;
+
+    bench_start(st);
+    for (i = 0; i < st->iterations; i++) {
+        generate_time_otp("mysecretkey", 30, (u64)time(NULL), buf, sizeof(buf));
+        bench_sink += buf[0];
+    }
+    bench_stop(st);
+}
+
+static const struct bench benches[] = {
+    { "BM_PoolAdd", BM_PoolAdd, 1000 },
+    { "BM_PoolAdd", BM_PoolAdd, 100000 },
+    { "BM_PoolAdd", BM_PoolAdd, 1000000 },
+    { "BM_PoolPick", BM_PoolPick, 1000 },
+    { "BM_PoolPick", BM_PoolPick, 100000 },
+    { "BM_PoolPick", BM_PoolPick, 1000000 },
+    { "BM_SessionPick", BM_SessionPick, 1000 },
+    { "BM_SessionPick", BM_SessionPick, 65536 },
+    { "BM_PoolList", BM_PoolList, 1000 },
+    { "BM_PoolList", BM_PoolList, 100000 },
+    { "BM_PoolList", BM_PoolList, 1000000 },
+    { "BM_PoolDelTail", BM_PoolDelTail, 1000 },
+    { "BM_PoolDelTail", BM_PoolDelTail, 100000 },
+    { "BM_PoolDelTail", BM_PoolDelTail, 1000000 },
+    { "BM_TruncateToOtp", BM_TruncateToOtp, 0 },
+    { "BM_HmacOtp", BM_HmacOtp, 0 },
+    { "BM_GenerateTimeOtp", BM_GenerateTimeOtp, 0 },
+};
+
+static void run_bench(const struct bench *b, const char *name, double min_time_ns) {
+    struct bench_state st = { .arg = b->arg };
+    long iters = 1;
+
+    for (;;) {
+        st.iterations = iters;
+        b->fn(&st);
+        if (st.wall_ns >= min_time_ns || iters >= 1000000000L)
+            break;
+
+        // comme Google Benchmark : vise min_time avec 40 % de marge, au plus x10
+        double next = st.wall_ns > 0 ? min_time_ns * 1.4 / (st.wall_ns / iters) : iters * 10.0;
+        if (next > iters * 10.0)
+            next = iters * 10.0;
+        iters = next > iters ? (long)next : iters + 1;
+    }
+
+    printf("%-32s %12.1f ns %12.1f ns %12ld\n", name,
+           st.wall_ns / st.iterations, st.cpu_ns / st.iterations, st.iterations);
+}
+
+void print_usage(const char *prog_name) {
+    printf("Utilisation : %s [--filter=<sous-chaîne>] [--min_time=<secondes>]\n", prog_name);
+    printf("Exemple : %s --filter=BM_PoolPick --min_time=1\n", prog_name);
+}
+
+int main(int argc, char *argv[]) {
+    const char *filter = NULL;
+    double min_time = 0.5;
+    char name[64];
+    size_t i;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--filter=", 9) == 0) {
+            filter = argv[a] + 9;
+        } else if (strncmp(argv[a], "--min_time=", 11) == 0) {
+            min_time = atof(argv[a] + 11);
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%-32s %15s %15s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+    printf("%.*s\n", 77, "-----------------------------------------------------------------------------");
+
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        if (benches[i].arg)
+            snprintf(name, sizeof(name), "%s/%ld", benches[i].name, benches[i].arg);
+        else
+            snprintf(name, sizeof(name), "%s", benches[i].name);
+
+        if (filter && !strstr(name, filter))
+            continue;
+
+        run_bench(&benches[i], name, min_time * 1e9);
+        fflush(stdout);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "otp_totp.h"
+
+// Vérifie le HMAC-SHA-1 de otp_shim.c (via timeotp_hmac_otp) contre les
+// vecteurs des RFC 4226 (annexe D) et RFC 6238 (annexe B, SHA-1, pas de 30 s),
+// comme le fait otp_time_kunit.c dans le kernel.
+
+static const char rfc_secret[] = "12345678901234567890";
+
+static const unsigned int rfc4226_otps[] = {
+    755224, 287082, 359152, 969429, 338314, 254676, 287922, 162583, 399871, 520489,
+};
+
+static const struct {
+    u64 time;
+    unsigned int otp; // valeur à 8 chiffres de la RFC, tronquée à OTP_DIGITS
+} rfc6238_vectors[] = {
+    { 59ULL, 94287082 },
+    { 1111111109ULL, 7081804 },
+    { 1111111111ULL, 14050471 },
+    { 1234567890ULL, 89005924 },
+    { 2000000000ULL, 69279037 },
+    { 20000000000ULL, 65353130 },
+};
+
+// generate_time_otp (sortie de /dev/timeotp0) hache le créneau dans l'ordre
+// d'octets natif : ses codes ne sont ceux de la RFC 6238 qu'en big-endian
+static const unsigned int device_otps[] = {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    160385, 110502, 133078, 98333, 187810, 188580,
+#else
+    94287082 % OTP_DIGITS_POWTEN, 7081804 % OTP_DIGITS_POWTEN,
+    14050471 % OTP_DIGITS_POWTEN, 89005924 % OTP_DIGITS_POWTEN,
+    69279037 % OTP_DIGITS_POWTEN, 65353130 % OTP_DIGITS_POWTEN,
+#endif
+};
+
+static int check_device(u64 time, unsigned int expected) {
+    char buf[64], want[16];
+
+    generate_time_otp(rfc_secret, 30, time, buf, sizeof(buf));
+    snprintf(want, sizeof(want), "%0*u\n", OTP_DIGITS, expected);
+    if (strcmp(buf, want) != 0) {
+        fprintf(stderr, "ÉCHEC generate_time_otp T = %llu : %s au lieu de %s",
+                (unsigned long long)time, buf, want);
+        return 1;
+    }
+    return 0;
+}
+
+static int check_counter(const char *what, u64 counter, unsigned int expected) {
+    u8 msg[8];
+    unsigned int otp = 0;
+    int i;
+
+    // compteur en big-endian, comme dans les RFC
+    for (i = 0; i < 8; i++)
+        msg[i] = (u8)(counter >> (56 - 8 * i));
+
+    if (timeotp_hmac_otp(rfc_secret, sizeof(rfc_secret) - 1, msg, sizeof(msg), &otp) != 0 ||
+        otp != expected) {
+        fprintf(stderr, "ÉCHEC %s : %06u au lieu de %06u\n", what, otp, expected);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    char what[64];
+    int failures = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(rfc4226_otps) / sizeof(rfc4226_otps[0]); i++) {
+        snprintf(what, sizeof(what), "RFC 4226 count %zu", i);
+        failures += check_counter(what, i, rfc4226_otps[i]);
+    }
+
+    for (i = 0; i < sizeof(rfc6238_vectors) / sizeof(rfc6238_vectors[0]); i++) {
+        snprintf(what, sizeof(what), "RFC 6238 T = %llu", (unsigned long long)rfc6238_vectors[i].time);
+        failures += check_counter(what, timeotp_slot(rfc6238_vectors[i].time, 30),
+                                  rfc6238_vectors[i].otp % OTP_DIGITS_POWTEN);
+    }
+
+    for (i = 0; i < sizeof(device_otps) / sizeof(device_otps[0]); i++)
+        failures += check_device(rfc6238_vectors[i].time, device_otps[i]);
+
+    if (failures) {
+        fprintf(stderr, "%d vecteur(s) en échec\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("otp_core_check : %zu vecteurs OK\n",
+           sizeof(rfc4226_otps) / sizeof(rfc4226_otps[0]) +
+           sizeof(rfc6238_vectors) / sizeof(rfc6238_vectors[0]) +
+           sizeof(device_otps) / sizeof(device_otps[0]));
+    return EXIT_SUCCESS;
+}
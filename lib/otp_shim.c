@@ -0,0 +1,250 @@
+#include <sys/random.h>
+
+#include "otp_shim.h"
+
+#define SHA1_BLOCK_SIZE 64
+#define SHA1_DIGEST_SIZE 20
+
+#define RANDOM_BUF_SIZE 4096
+
+// Comme le get_random_bytes du kernel, l'aléa est servi depuis une réserve par
+// thread : un appel à getrandom() pour RANDOM_BUF_SIZE octets, et non à chaque tirage
+static __thread u8 random_buf[RANDOM_BUF_SIZE];
+static __thread size_t random_pos = RANDOM_BUF_SIZE;
+
+static void random_refill(void) {
+    size_t filled = 0;
+
+    while (filled < RANDOM_BUF_SIZE) {
+        ssize_t n = getrandom(random_buf + filled, RANDOM_BUF_SIZE - filled, 0);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            abort(); // le kernel ne peut pas échouer ici non plus
+        }
+        filled += n;
+    }
+    random_pos = 0;
+}
+
+void get_random_bytes(void *buf, size_t len) {
+    u8 *p = buf;
+
+    while (len > 0) {
+        size_t n;
+
+        if (random_pos == RANDOM_BUF_SIZE)
+            random_refill();
+
+        n = RANDOM_BUF_SIZE - random_pos;
+        if (n > len)
+            n = len;
+        memcpy(p, random_buf + random_pos, n);
+        // les octets servis sont effacés, comme les lots du CRNG kernel
+        memset(random_buf + random_pos, 0, n);
+        random_pos += n;
+        p += n;
+        len -= n;
+    }
+}
+
+u32 get_random_u32_below(u32 ceil) {
+    u64 mult;
+    u32 rand;
+
+    // méthode de Lemire : multiplication 32x32 -> 64 et rejet du biais
+    get_random_bytes(&rand, sizeof(rand));
+    mult = (u64)ceil * rand;
+    if ((u32)mult < ceil) {
+        u32 bound = -ceil % ceil;
+        while ((u32)mult < bound) {
+            get_random_bytes(&rand, sizeof(rand));
+            mult = (u64)ceil * rand;
+        }
+    }
+    return mult >> 32;
+}
+
+// SHA-1 (FIPS 180-4), suffisant pour HMAC-SHA-1 (RFC 2104)
+struct sha1_state {
+    u32 h[5];
+    u64 count;
+    u8 buffer[SHA1_BLOCK_SIZE];
+};
+
+#define ROL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void sha1_transform(u32 h[5], const u8 *block) {
+    u32 w[80];
+    u32 a, b, c, d, e, f, k, t;
+    int i;
+
+    for (i = 0; i < 16; i++)
+        w[i] = (u32)block[4 * i] << 24 | (u32)block[4 * i + 1] << 16 |
+               (u32)block[4 * i + 2] << 8 | (u32)block[4 * i + 3];
+    for (i = 16; i < 80; i++)
+        w[i] = ROL32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    a = h[0];
+    b = h[1];
+    c = h[2];
+    d = h[3];
+    e = h[4];
+
+    for (i = 0; i < 80; i++) {
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5a827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ed9eba1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8f1bbcdc;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xca62c1d6;
+        }
+        t = ROL32(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = ROL32(b, 30);
+        b = a;
+        a = t;
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+static void sha1_init(struct sha1_state *st) {
+    st->h[0] = 0x67452301;
+    st->h[1] = 0xefcdab89;
+    st->h[2] = 0x98badcfe;
+    st->h[3] = 0x10325476;
+    st->h[4] = 0xc3d2e1f0;
+    st->count = 0;
+}
+
+static void sha1_update(struct sha1_state *st, const u8 *data, size_t len) {
+    size_t fill = st->count % SHA1_BLOCK_SIZE;
+
+    st->count += len;
+
+    if (fill) {
+        size_t n = SHA1_BLOCK_SIZE - fill;
+        if (n > len)
+            n = len;
+        memcpy(st->buffer + fill, data, n);
+        data += n;
+        len -= n;
+        if (fill + n < SHA1_BLOCK_SIZE)
+            return;
+        sha1_transform(st->h, st->buffer);
+    }
+
+    for (; len >= SHA1_BLOCK_SIZE; data += SHA1_BLOCK_SIZE, len -= SHA1_BLOCK_SIZE)
+        sha1_transform(st->h, data);
+
+    memcpy(st->buffer, data, len);
+}
+
+static void sha1_final(struct sha1_state *st, u8 *out) {
+    static const u8 pad[SHA1_BLOCK_SIZE] = { 0x80 };
+    u64 bits = st->count * 8;
+    size_t fill = st->count % SHA1_BLOCK_SIZE;
+    u8 len_be[8];
+    int i;
+
+    for (i = 0; i < 8; i++)
+        len_be[i] = (u8)(bits >> (56 - 8 * i));
+
+    sha1_update(st, pad, fill < 56 ? 56 - fill : 120 - fill);
+    sha1_update(st, len_be, sizeof(len_be));
+
+    for (i = 0; i < 5; i++) {
+        out[4 * i] = (u8)(st->h[i] >> 24);
+        out[4 * i + 1] = (u8)(st->h[i] >> 16);
+        out[4 * i + 2] = (u8)(st->h[i] >> 8);
+        out[4 * i + 3] = (u8)st->h[i];
+    }
+}
+
+// hmac(sha1) : le tfm garde les blocs ipad/opad dérivés de la clé
+struct crypto_shash {
+    u8 ipad[SHA1_BLOCK_SIZE];
+    u8 opad[SHA1_BLOCK_SIZE];
+};
+
+struct crypto_shash *crypto_alloc_shash(const char *alg_name, u32 type, u32 mask) {
+    struct crypto_shash *tfm;
+
+    (void)type;
+    (void)mask;
+
+    if (strcmp(alg_name, "hmac(sha1)") != 0)
+        return ERR_PTR(-ENOENT);
+
+    tfm = calloc(1, sizeof(*tfm));
+    if (!tfm)
+        return ERR_PTR(-ENOMEM);
+    return tfm;
+}
+
+void crypto_free_shash(struct crypto_shash *tfm) {
+    free(tfm);
+}
+
+unsigned int crypto_shash_descsize(struct crypto_shash *tfm) {
+    (void)tfm;
+    return sizeof(struct sha1_state);
+}
+
+int crypto_shash_setkey(struct crypto_shash *tfm, const u8 *key, unsigned int keylen) {
+    u8 key_block[SHA1_BLOCK_SIZE] = { 0 };
+    struct sha1_state st;
+    int i;
+
+    // une clé plus longue qu'un bloc est d'abord hachée (RFC 2104)
+    if (keylen > SHA1_BLOCK_SIZE) {
+        sha1_init(&st);
+        sha1_update(&st, key, keylen);
+        sha1_final(&st, key_block);
+    } else {
+        memcpy(key_block, key, keylen);
+    }
+
+    for (i = 0; i < SHA1_BLOCK_SIZE; i++) {
+        tfm->ipad[i] = key_block[i] ^ 0x36;
+        tfm->opad[i] = key_block[i] ^ 0x5c;
+    }
+    return 0;
+}
+
+int crypto_shash_init(struct shash_desc *desc) {
+    struct sha1_state *st = (struct sha1_state *)desc->__ctx;
+
+    sha1_init(st);
+    sha1_update(st, desc->tfm->ipad, SHA1_BLOCK_SIZE);
+    return 0;
+}
+
+int crypto_shash_update(struct shash_desc *desc, const u8 *data, unsigned int len) {
+    sha1_update((struct sha1_state *)desc->__ctx, data, len);
+    return 0;
+}
+
+int crypto_shash_final(struct shash_desc *desc, u8 *out) {
+    struct sha1_state *st = (struct sha1_state *)desc->__ctx;
+    u8 inner[SHA1_DIGEST_SIZE];
+
+    sha1_final(st, inner);
+    sha1_init(st);
+    sha1_update(st, desc->tfm->opad, SHA1_BLOCK_SIZE);
+    sha1_update(st, inner, sizeof(inner));
+    sha1_final(st, out);
+    return 0;
+}
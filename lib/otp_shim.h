@@ -0,0 +1,130 @@
+#ifndef OTP_SHIM_H
+#define OTP_SHIM_H
+
+// Équivalents userspace des API kernel utilisées par src/otp_pool.c et
+// src/otp_totp.c : listes, mutex, allocation, aléa et crypto_shash (hmac(sha1)).
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+// allocation
+#define GFP_KERNEL 0
+#define kmalloc(size, flags) malloc(size)
+#define kzalloc(size, flags) calloc(1, size)
+#define kfree(ptr) free(ptr)
+#define kvmalloc_array(n, size, flags) calloc(n, size)
+#define kvfree(ptr) free(ptr)
+
+// pointeurs d'erreur
+#define MAX_ERRNO 4095
+#define IS_ERR(ptr) ((uintptr_t)(ptr) >= (uintptr_t)-MAX_ERRNO)
+#define PTR_ERR(ptr) ((long)(intptr_t)(ptr))
+#define ERR_PTR(err) ((void *)(intptr_t)(err))
+
+// accès concurrents (builtins atomiques de GCC)
+#define READ_ONCE(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define WRITE_ONCE(x, val) __atomic_store_n(&(x), (val), __ATOMIC_RELAXED)
+#define smp_load_acquire(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define smp_store_release(p, val) __atomic_store_n(p, val, __ATOMIC_RELEASE)
+#define cmpxchg(p, old, new) __sync_val_compare_and_swap(p, old, new)
+
+#define container_of(ptr, type, member) \
+    ((type *)((char *)(ptr) - offsetof(type, member)))
+
+// listes doublement chaînées (sous-ensemble de <linux/list.h>)
+struct list_head {
+    struct list_head *next, *prev;
+};
+
+static inline void INIT_LIST_HEAD(struct list_head *list) {
+    list->next = list;
+    list->prev = list;
+}
+
+static inline void __list_add(struct list_head *new, struct list_head *prev, struct list_head *next) {
+    next->prev = new;
+    new->next = next;
+    new->prev = prev;
+    prev->next = new;
+}
+
+static inline void list_add(struct list_head *new, struct list_head *head) {
+    __list_add(new, head, head->next);
+}
+
+static inline void list_add_tail(struct list_head *new, struct list_head *head) {
+    __list_add(new, head->prev, head);
+}
+
+static inline void list_del(struct list_head *entry) {
+    entry->next->prev = entry->prev;
+    entry->prev->next = entry->next;
+    entry->next = NULL;
+    entry->prev = NULL;
+}
+
+static inline void list_del_init(struct list_head *entry) {
+    entry->next->prev = entry->prev;
+    entry->prev->next = entry->next;
+    INIT_LIST_HEAD(entry);
+}
+
+static inline int list_empty(const struct list_head *head) {
+    return head->next == head;
+}
+
+#define list_entry(ptr, type, member) container_of(ptr, type, member)
+#define list_first_entry(ptr, type, member) list_entry((ptr)->next, type, member)
+#define list_next_entry(pos, member) list_entry((pos)->member.next, __typeof__(*(pos)), member)
+
+#define list_for_each_entry(pos, head, member)                       \
+    for (pos = list_first_entry(head, __typeof__(*pos), member);     \
+         &pos->member != (head);                                     \
+         pos = list_next_entry(pos, member))
+
+#define list_for_each_entry_safe(pos, n, head, member)               \
+    for (pos = list_first_entry(head, __typeof__(*pos), member),     \
+         n = list_next_entry(pos, member);                           \
+         &pos->member != (head);                                     \
+         pos = n, n = list_next_entry(n, member))
+
+// mutex
+struct mutex {
+    pthread_mutex_t lock;
+};
+
+#define mutex_init(m) pthread_mutex_init(&(m)->lock, NULL)
+#define mutex_lock(m) pthread_mutex_lock(&(m)->lock)
+#define mutex_unlock(m) pthread_mutex_unlock(&(m)->lock)
+#define mutex_destroy(m) pthread_mutex_destroy(&(m)->lock)
+
+// aléa (getrandom)
+void get_random_bytes(void *buf, size_t len);
+u32 get_random_u32_below(u32 ceil);
+
+// crypto_shash : seul "hmac(sha1)" est disponible
+struct crypto_shash;
+
+struct shash_desc {
+    struct crypto_shash *tfm;
+    void *__ctx[] __attribute__((aligned(8)));
+};
+
+struct crypto_shash *crypto_alloc_shash(const char *alg_name, u32 type, u32 mask);
+void crypto_free_shash(struct crypto_shash *tfm);
+unsigned int crypto_shash_descsize(struct crypto_shash *tfm);
+int crypto_shash_setkey(struct crypto_shash *tfm, const u8 *key, unsigned int keylen);
+int crypto_shash_init(struct shash_desc *desc);
+int crypto_shash_update(struct shash_desc *desc, const u8 *data, unsigned int len);
+int crypto_shash_final(struct shash_desc *desc, u8 *out);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef OTP_COMPAT_H
+#define OTP_COMPAT_H
+
+// Le cœur (otp_pool.c, otp_totp.c) se compile dans les modules kernel et,
+// via la couche de compatibilité de lib/, dans une bibliothèque userspace.
+#ifdef __KERNEL__
+#include <linux/types.h>
+#include <linux/kernel.h>
+#include <linux/compiler.h>
+#include <linux/atomic.h>
+#include <linux/list.h>
+#include <linux/slab.h>
+#include <linux/mutex.h>
+#include <linux/string.h>
+#include <linux/random.h>
+#include <linux/err.h>
+#include <linux/math64.h>
+#include <crypto/hash.h>
+#else
+#include "otp_shim.h"
+#endif
+
+#endif
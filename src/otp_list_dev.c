@@ -3,13 +3,11 @@
 #include <linux/fs.h>
 #include <linux/cdev.h>
 #include <linux/uaccess.h>
-#include <linux/list.h>
 #include <linux/slab.h>
-#include <linux/mutex.h>
 #include <linux/ioctl.h>
 #include <linux/device.h>
-#include <linux/string.h>
-#include <linux/random.h> // Pour get_random_bytes
+
+#include "otp_pool.h"
 
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("Xavier, Eleonore, Alexis");
@@ -22,20 +20,15 @@ MODULE_VERSION("1.1");
 #define OTP_IOC_ADD _IOW(OTP_IOC_MAGIC, 1, char *)
 #define OTP_IOC_DEL _IOW(OTP_IOC_MAGIC, 2, char *)
 #define OTP_IOC_LIST _IOR(OTP_IOC_MAGIC, 3, char *)
+#define OTP_IOC_RESERVE _IOW(OTP_IOC_MAGIC, 4, int)
 #define MAX_DEVICES 5
 
 static dev_t dev_num_base;
 static struct class* otp_class = NULL;
 
-struct otp_entry {
-    char password[32];
-    struct list_head list;
-};
-
 struct otp_device {
     struct cdev cdev;
-    struct list_head otp_list_head;
-    struct mutex list_mutex;
+    struct otp_pool pool;
     struct device* device;
 };
 
@@ -48,60 +41,41 @@ static char *otp_devnode(const struct device *dev, umode_t *mode) {
     return NULL;
 }
 
+// Chaque fichier ouvert a sa session, vide tant que OTP_IOC_RESERVE n'est pas appelé
 static int otp_open(struct inode *inodep, struct file *filep) {
     struct otp_device *otp_dev = container_of(inodep->i_cdev, struct otp_device, cdev);
-    filep->private_data = otp_dev;
+    struct otp_session *session;
+
+    session = kmalloc(sizeof(*session), GFP_KERNEL);
+    if (!session)
+        return -ENOMEM;
+
+    otp_session_init(session, &otp_dev->pool);
+    filep->private_data = session;
     return 0;
 }
 
 static int otp_release(struct inode *inodep, struct file *filep) {
+    struct otp_session *session = filep->private_data;
+
+    otp_session_release(session);
+    kfree(session);
     return 0;
 }
 
 static ssize_t otp_read(struct file *filep, char __user *buffer, size_t len, loff_t *offset) {
-    struct otp_device *otp_dev = filep->private_data;
-    struct otp_entry *entry;
+    struct otp_session *session = filep->private_data;
     char otp_buf[64];
-    size_t otp_len = 0;
-    int count = 0;
-    int random_index;
-    int i = 0;
+    size_t otp_len;
 
     if (*offset > 0)
         return 0;
 
-    mutex_lock(&otp_dev->list_mutex);
-
-    if (list_empty(&otp_dev->otp_list_head)) {
-        mutex_unlock(&otp_dev->list_mutex);
-        return 0;
-    }
-
-    // Compter le nombre d'entrées
-    list_for_each_entry(entry, &otp_dev->otp_list_head, list) {
-        count++;
-    }
-
-    // Générer un index aléatoire
-    if (count == 1) {
-        random_index = 0;
-    } else {
-        get_random_bytes(&random_index, sizeof(random_index));
-        random_index = abs(random_index) % count;
-    }
-
-    // Trouver l'entrée correspondant à random_index
-    list_for_each_entry(entry, &otp_dev->otp_list_head, list) {
-        if (i == random_index)
-            break;
-        i++;
-    }
-
-    // Copier le mot de passe dans le buffer
-    otp_len = snprintf(otp_buf, sizeof(otp_buf), "%s\n", entry->password);
-
-    mutex_unlock(&otp_dev->list_mutex);
-
+    // la réserve de la session est servie sans prendre le mutex du pool ;
+    // si elle est vide ou entièrement révoquée, on tire dans le pool
+    otp_len = otp_session_pick(session, otp_buf, sizeof(otp_buf));
+    if (otp_len == 0)
+        otp_len = otp_pool_pick(session->pool, otp_buf, sizeof(otp_buf));
     if (otp_len == 0)
         return 0;
 
@@ -111,17 +85,18 @@ static ssize_t otp_read(struct file *filep, char __user *buffer, size_t len, lof
     if (copy_to_user(buffer, otp_buf, otp_len))
         return -EFAULT;
     
-    printk(KERN_INFO "otp: Mot de passe généré avec succès\n");
+    // chemin chaud (sessions sans verrou) : pas de printk à chaque lecture
+    pr_debug("otp: Mot de passe généré avec succès\n");
 
     *offset += otp_len;
     return otp_len;
 }
 
 static long otp_ioctl(struct file *filep, unsigned int cmd, unsigned long arg) {
-    struct otp_device *otp_dev = filep->private_data;
+    struct otp_session *session = filep->private_data;
     char kbuf[64];
-    struct otp_entry *new_entry, *entry, *tmp;
     char __user *user_arg = (char __user *)arg;
+    int ret;
 
     switch (cmd) {
         case OTP_IOC_ADD:
@@ -129,18 +104,11 @@ static long otp_ioctl(struct file *filep, unsigned int cmd, unsigned long arg) {
                 return -EFAULT;
             kbuf[sizeof(kbuf) - 1] = '\0';
 
-            new_entry = kmalloc(sizeof(*new_entry), GFP_KERNEL);
-            if (!new_entry)
-                return -ENOMEM;
-
-            strncpy(new_entry->password, kbuf, sizeof(new_entry->password) - 1);
-            new_entry->password[sizeof(new_entry->password) - 1] = '\0';
-
-            mutex_lock(&otp_dev->list_mutex);
-            list_add_tail(&new_entry->list, &otp_dev->otp_list_head);
-            mutex_unlock(&otp_dev->list_mutex);
+            ret = otp_pool_add(session->pool, kbuf);
+            if (ret)
+                return ret;
 
-            printk(KERN_INFO "otp: Mot de passe ajouté: %s\n", new_entry->password);
+            printk(KERN_INFO "otp: Mot de passe ajouté: %.31s\n", kbuf);
             break;
 
         case OTP_IOC_DEL:
@@ -148,37 +116,19 @@ static long otp_ioctl(struct file *filep, unsigned int cmd, unsigned long arg) {
                 return -EFAULT;
             kbuf[sizeof(kbuf) - 1] = '\0';
 
-            mutex_lock(&otp_dev->list_mutex);
-            list_for_each_entry_safe(entry, tmp, &otp_dev->otp_list_head, list) {
-                if (strncmp(entry->password, kbuf, sizeof(entry->password)) == 0) {
-                    list_del(&entry->list);
-                    kfree(entry);
-                    printk(KERN_INFO "otp: Mot de passe supprimé: %s\n", kbuf);
-                    break;
-                }
-            }
-            mutex_unlock(&otp_dev->list_mutex);
+            if (otp_pool_del(session->pool, kbuf))
+                printk(KERN_INFO "otp: Mot de passe supprimé: %s\n", kbuf);
             break;
 
         case OTP_IOC_LIST: {
             char *list_buf;
-            size_t buf_size = 1024;
-            size_t pos = 0;
-            struct otp_entry *e;
+            size_t pos;
 
-            list_buf = kmalloc(buf_size, GFP_KERNEL);
+            list_buf = kzalloc(OTP_LIST_BUF_SIZE, GFP_KERNEL);
             if (!list_buf)
                 return -ENOMEM;
-            memset(list_buf, 0, buf_size);
-
-            mutex_lock(&otp_dev->list_mutex);
-            list_for_each_entry(e, &otp_dev->otp_list_head, list) {
-                int n = snprintf(list_buf + pos, buf_size - pos, "%s\n", e->password);
-                if (n < 0 || n >= (int)(buf_size - pos))
-                    break;
-                pos += n;
-            }
-            mutex_unlock(&otp_dev->list_mutex);
+
+            pos = otp_pool_list(session->pool, list_buf, OTP_LIST_BUF_SIZE);
 
             if (copy_to_user(user_arg, list_buf, pos)) {
                 kfree(list_buf);
@@ -189,6 +139,22 @@ static long otp_ioctl(struct file *filep, unsigned int cmd, unsigned long arg) {
             return pos;
         }
 
+        case OTP_IOC_RESERVE: {
+            int count;
+
+            if (copy_from_user(&count, (int __user *)arg, sizeof(count)))
+                return -EFAULT;
+            if (count <= 0)
+                return -EINVAL;
+
+            ret = otp_session_reserve(session, count);
+            if (ret < 0)
+                return ret;
+
+            printk(KERN_INFO "otp: %d mots de passe réservés\n", ret);
+            return ret;
+        }
+
         default:
             return -EINVAL;
     }
@@ -237,8 +203,7 @@ static int __init otp_init(void) {
             return ret;
         }
 
-        INIT_LIST_HEAD(&otp_devices[i].otp_list_head);
-        mutex_init(&otp_devices[i].list_mutex);
+        otp_pool_init(&otp_devices[i].pool);
 
         otp_devices[i].device = device_create(otp_class, NULL, dev_num_base + i, NULL, "otpdev%d", i);
         if (IS_ERR(otp_devices[i].device)) {
@@ -264,14 +229,8 @@ static void __exit otp_exit(void) {
         device_destroy(otp_class, dev_num_base + i);
         cdev_del(&otp_devices[i].cdev);
 
-        struct otp_entry *entry, *tmp;
-        mutex_lock(&otp_devices[i].list_mutex);
-        list_for_each_entry_safe(entry, tmp, &otp_devices[i].otp_list_head, list) {
-            list_del(&entry->list);
-            kfree(entry);
-        }
-        mutex_unlock(&otp_devices[i].list_mutex);
-        mutex_destroy(&otp_devices[i].list_mutex);
+        otp_pool_clear(&otp_devices[i].pool);
+        mutex_destroy(&otp_devices[i].pool.list_mutex);
     }
 
     class_destroy(otp_class);
@@ -281,3 +240,4 @@ static void __exit otp_exit(void) {
 
 module_init(otp_init);
 module_exit(otp_exit);
+
@@ -0,0 +1,427 @@
+// Tests KUnit du pool de otp_list, liés au module avec make KUNIT=1
+#include <kunit/test.h>
+#include <linux/ktime.h>
+
+#include "otp_pool.h"
+
+#define OTP_TEST_PICKS 2000
+#define OTP_BENCH_PICKS 100
+
+static int otp_list_test_init(struct kunit *test) {
+    struct otp_pool *pool;
+
+    pool = kunit_kzalloc(test, sizeof(*pool), GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, pool);
+    otp_pool_init(pool);
+    test->priv = pool;
+    return 0;
+}
+
+static void otp_list_test_exit(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+
+    otp_pool_clear(pool);
+    mutex_destroy(&pool->list_mutex);
+}
+
+static size_t otp_test_count(struct otp_pool *pool) {
+    struct otp_entry *entry;
+    size_t count = 0;
+
+    list_for_each_entry(entry, &pool->otp_list_head, list)
+        count++;
+    return count;
+}
+
+static void otp_test_add_basic(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    char buf[OTP_LIST_BUF_SIZE];
+
+    KUNIT_EXPECT_EQ(test, otp_pool_add(pool, "alpha"), 0);
+    KUNIT_EXPECT_EQ(test, otp_pool_add(pool, "beta"), 0);
+    KUNIT_EXPECT_EQ(test, otp_test_count(pool), (size_t)2);
+
+    // l'ordre d'insertion est conservé
+    KUNIT_EXPECT_EQ(test, otp_pool_list(pool, buf, sizeof(buf)), strlen("alpha\nbeta\n"));
+    KUNIT_EXPECT_STREQ(test, buf, "alpha\nbeta\n");
+}
+
+static void otp_test_add_truncates(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    struct otp_entry *entry;
+    char longpw[64];
+
+    memset(longpw, 'x', sizeof(longpw) - 1);
+    longpw[sizeof(longpw) - 1] = '\0';
+
+    KUNIT_EXPECT_EQ(test, otp_pool_add(pool, longpw), 0);
+    entry = list_first_entry(&pool->otp_list_head, struct otp_entry, list);
+    KUNIT_EXPECT_EQ(test, strlen(entry->password), sizeof(entry->password) - 1);
+
+    // la suppression compare les 32 premiers octets : le mot de passe long ne correspond pas
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, longpw), 0);
+    longpw[sizeof(entry->password) - 1] = '\0';
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, longpw), 1);
+    KUNIT_EXPECT_TRUE(test, list_empty(&pool->otp_list_head));
+}
+
+static void otp_test_add_empty(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    char buf[8];
+
+    KUNIT_EXPECT_EQ(test, otp_pool_add(pool, ""), 0);
+    KUNIT_EXPECT_EQ(test, otp_pool_pick(pool, buf, sizeof(buf)), (size_t)1);
+    KUNIT_EXPECT_STREQ(test, buf, "\n");
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, ""), 1);
+}
+
+static void otp_test_del(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    char buf[OTP_LIST_BUF_SIZE];
+
+    // suppression sur une liste vide
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "absent"), 0);
+
+    otp_pool_add(pool, "a");
+    otp_pool_add(pool, "b");
+    otp_pool_add(pool, "a");
+
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "absent"), 0);
+    KUNIT_EXPECT_EQ(test, otp_test_count(pool), (size_t)3);
+
+    // un doublon : seule la première occurrence est retirée
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "a"), 1);
+    otp_pool_list(pool, buf, sizeof(buf));
+    KUNIT_EXPECT_STREQ(test, buf, "b\na\n");
+
+    // pas de correspondance sur un préfixe
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "bb"), 0);
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "b"), 1);
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "a"), 1);
+    KUNIT_EXPECT_TRUE(test, list_empty(&pool->otp_list_head));
+}
+
+static void otp_test_list_empty(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    char buf[OTP_LIST_BUF_SIZE] = "";
+
+    KUNIT_EXPECT_EQ(test, otp_pool_list(pool, buf, sizeof(buf)), (size_t)0);
+    KUNIT_EXPECT_STREQ(test, buf, "");
+}
+
+static void otp_test_list_truncation(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    char *buf;
+    char pw[32];
+    size_t pos;
+    int i;
+
+    buf = kunit_kzalloc(test, OTP_LIST_BUF_SIZE, GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, buf);
+
+    // 40 mots de passe de 31 caractères : 32 octets par ligne avec le '\n'
+    for (i = 0; i < 40; i++) {
+        snprintf(pw, sizeof(pw), "%02d%029d", i, 0);
+        KUNIT_ASSERT_EQ(test, otp_pool_add(pool, pw), 0);
+    }
+
+    // 31 lignes tiennent (992 octets), la 32e est refusée car le '\0' ne rentre plus
+    pos = otp_pool_list(pool, buf, OTP_LIST_BUF_SIZE);
+    KUNIT_EXPECT_EQ(test, pos, (size_t)(31 * 32));
+    KUNIT_EXPECT_EQ(test, buf[pos - 1], '\n');
+    KUNIT_EXPECT_EQ(test, strnlen(buf, OTP_LIST_BUF_SIZE), pos);
+    KUNIT_EXPECT_EQ(test, strncmp(buf + 30 * 32, "30", 2), 0);
+}
+
+static void otp_test_list_small_buffer(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    char buf[6];
+
+    otp_pool_add(pool, "abcd");
+    otp_pool_add(pool, "ef");
+
+    // "abcd\n" tient tout juste, "ef\n" n'est pas coupé
+    KUNIT_EXPECT_EQ(test, otp_pool_list(pool, buf, sizeof(buf)), (size_t)5);
+    KUNIT_EXPECT_STREQ(test, buf, "abcd\n");
+}
+
+static void otp_test_pick_empty(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    char buf[64];
+
+    KUNIT_EXPECT_EQ(test, otp_pool_pick(pool, buf, sizeof(buf)), (size_t)0);
+}
+
+static void otp_test_pick_single(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    char buf[64];
+    int i;
+
+    otp_pool_add(pool, "unique");
+    for (i = 0; i < 100; i++) {
+        KUNIT_ASSERT_EQ(test, otp_pool_pick(pool, buf, sizeof(buf)), strlen("unique\n"));
+        KUNIT_ASSERT_STREQ(test, buf, "unique\n");
+    }
+}
+
+static void otp_test_pick_random(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    unsigned int hits[8] = { 0 };
+    char pw[8], buf[64];
+    unsigned int i;
+    int idx;
+
+    for (i = 0; i < ARRAY_SIZE(hits); i++) {
+        snprintf(pw, sizeof(pw), "pw%u", i);
+        otp_pool_add(pool, pw);
+    }
+
+    for (i = 0; i < OTP_TEST_PICKS; i++) {
+        KUNIT_ASSERT_EQ(test, otp_pool_pick(pool, buf, sizeof(buf)), (size_t)4);
+        KUNIT_ASSERT_EQ(test, sscanf(buf, "pw%d", &idx), 1);
+        KUNIT_ASSERT_TRUE(test, idx >= 0 && idx < (int)ARRAY_SIZE(hits));
+        hits[idx]++;
+    }
+
+    // 2000 tirages sur 8 entrées : espérance 250, toutes doivent sortir
+    for (i = 0; i < ARRAY_SIZE(hits); i++) {
+        KUNIT_EXPECT_GT(test, hits[i], 0U);
+        KUNIT_EXPECT_LT(test, hits[i], (unsigned int)OTP_TEST_PICKS / 2);
+    }
+
+    // le tirage ne consomme pas les entrées
+    KUNIT_EXPECT_EQ(test, otp_test_count(pool), ARRAY_SIZE(hits));
+}
+
+static void otp_test_pick_truncated_buffer(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    char buf[4];
+
+    otp_pool_add(pool, "abcdef");
+
+    // snprintf retourne la longueur complète, otp_read la borne ensuite à len
+    KUNIT_EXPECT_EQ(test, otp_pool_pick(pool, buf, sizeof(buf)), strlen("abcdef\n"));
+    KUNIT_EXPECT_STREQ(test, buf, "abc");
+}
+
+static void otp_test_session_reserve(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    struct otp_session session;
+    char buf[OTP_LIST_BUF_SIZE];
+    char pw[8];
+    int i;
+
+    otp_session_init(&session, pool);
+
+    // pool vide : rien à réserver, la lecture retombe sur le pool et la
+    // session peut réessayer plus tard
+    KUNIT_EXPECT_EQ(test, otp_session_reserve(&session, 4), 0);
+    KUNIT_EXPECT_EQ(test, otp_session_pick(&session, buf, sizeof(buf)), (size_t)0);
+    KUNIT_EXPECT_EQ(test, session.reserved, 0);
+
+    for (i = 0; i < 5; i++) {
+        snprintf(pw, sizeof(pw), "s%d", i);
+        otp_pool_add(pool, pw);
+    }
+
+    // les entrées réservées sont prises en tête et disparaissent du pool
+    KUNIT_EXPECT_EQ(test, otp_session_reserve(&session, 3), 3);
+    KUNIT_EXPECT_EQ(test, session.count, 3U);
+    otp_pool_list(pool, buf, sizeof(buf));
+    KUNIT_EXPECT_STREQ(test, buf, "s3\ns4\n");
+
+    // la réserve est immuable : une seconde réservation est refusée
+    KUNIT_EXPECT_EQ(test, otp_session_reserve(&session, 2), -EBUSY);
+    KUNIT_EXPECT_EQ(test, session.count, 3U);
+
+    // release rend tout au pool, en fin de liste et dans l'ordre de réservation
+    otp_session_release(&session);
+    KUNIT_EXPECT_EQ(test, session.count, 0U);
+    KUNIT_EXPECT_NULL(test, session.entries);
+    KUNIT_EXPECT_TRUE(test, list_empty(&pool->sessions));
+    otp_pool_list(pool, buf, sizeof(buf));
+    KUNIT_EXPECT_STREQ(test, buf, "s3\ns4\ns0\ns1\ns2\n");
+
+    // demande supérieure au pool : seules les entrées disponibles sont réservées
+    otp_session_init(&session, pool);
+    KUNIT_EXPECT_EQ(test, otp_session_reserve(&session, 10), 5);
+    KUNIT_EXPECT_TRUE(test, list_empty(&pool->otp_list_head));
+    otp_session_release(&session);
+
+    // release d'une session vide
+    otp_session_release(&session);
+    KUNIT_EXPECT_EQ(test, otp_test_count(pool), (size_t)5);
+}
+
+static void otp_test_session_revoke(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    struct otp_session session;
+    char buf[OTP_LIST_BUF_SIZE];
+    unsigned int hits[4] = { 0 };
+    char pw[8];
+    unsigned int i, bad = 0;
+    int idx;
+
+    for (i = 0; i < 5; i++) {
+        snprintf(pw, sizeof(pw), "r%u", i);
+        otp_pool_add(pool, pw);
+    }
+
+    otp_session_init(&session, pool);
+    KUNIT_EXPECT_EQ(test, otp_session_reserve(&session, ARRAY_SIZE(hits)), (int)ARRAY_SIZE(hits));
+
+    // del trouve l'entrée réservée et la révoque au lieu de l'ignorer
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "r0"), 1);
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "r0"), 0);
+    for (i = 0; i < OTP_TEST_PICKS; i++) {
+        if (otp_session_pick(&session, buf, sizeof(buf)) != 3 ||
+            sscanf(buf, "r%d", &idx) != 1 || idx < 1 || idx >= (int)ARRAY_SIZE(hits)) {
+            bad++;
+            continue;
+        }
+        hits[idx]++;
+    }
+    KUNIT_EXPECT_EQ(test, bad, 0U);
+
+    // les entrées restantes gardent chacune 1/3 des tirages (~667 sur 2000,
+    // écart type ~21) ; l'entrée suivant une révoquée ne doit pas en prendre 1/2
+    for (i = 1; i < ARRAY_SIZE(hits); i++) {
+        KUNIT_EXPECT_GT(test, hits[i], OTP_TEST_PICKS / 4U);
+        KUNIT_EXPECT_LT(test, hits[i], OTP_TEST_PICKS * 5U / 12);
+    }
+
+    // toutes les entrées révoquées : la session ne sert plus rien
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "r1"), 1);
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "r2"), 1);
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, "r3"), 1);
+    KUNIT_EXPECT_EQ(test, otp_session_pick(&session, buf, sizeof(buf)), (size_t)0);
+
+    // les entrées révoquées sont libérées au release, pas rendues au pool
+    otp_session_release(&session);
+    otp_pool_list(pool, buf, sizeof(buf));
+    KUNIT_EXPECT_STREQ(test, buf, "r4\n");
+}
+
+static void otp_test_session_pick(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    struct otp_session session;
+    unsigned int hits[4] = { 0 };
+    char pw[8], buf[64];
+    unsigned int i, bad = 0;
+    int idx;
+
+    for (i = 0; i < 8; i++) {
+        snprintf(pw, sizeof(pw), "pw%u", i);
+        otp_pool_add(pool, pw);
+    }
+
+    otp_session_init(&session, pool);
+    KUNIT_EXPECT_EQ(test, otp_session_reserve(&session, ARRAY_SIZE(hits)), (int)ARRAY_SIZE(hits));
+
+    // seules les entrées de la session (pw0 à pw3) peuvent sortir ; pas d'ASSERT
+    // ici pour toujours rendre les entrées au pool avant la fin du test
+    for (i = 0; i < OTP_TEST_PICKS; i++) {
+        if (otp_session_pick(&session, buf, sizeof(buf)) != 4 ||
+            sscanf(buf, "pw%d", &idx) != 1 || idx < 0 || idx >= (int)ARRAY_SIZE(hits)) {
+            bad++;
+            continue;
+        }
+        hits[idx]++;
+    }
+
+    KUNIT_EXPECT_EQ(test, bad, 0U);
+    for (i = 0; i < ARRAY_SIZE(hits); i++)
+        KUNIT_EXPECT_GT(test, hits[i], 0U);
+
+    otp_session_release(&session);
+    KUNIT_EXPECT_EQ(test, otp_test_count(pool), (size_t)8);
+}
+
+// Microbenchmarks du pool : temps par opération pour 1K, 100K et 1M entrées
+static const unsigned int otp_bench_sizes[] = { 1000, 100000, 1000000 };
+
+static void otp_bench_size_desc(const unsigned int *size, char *desc) {
+    snprintf(desc, KUNIT_PARAM_DESC_SIZE, "%u entries", *size);
+}
+
+KUNIT_ARRAY_PARAM(otp_bench, otp_bench_sizes, otp_bench_size_desc);
+
+static void otp_bench_pool(struct kunit *test) {
+    struct otp_pool *pool = test->priv;
+    unsigned int size = *(const unsigned int *)test->param_value;
+    char pw[32], buf[64];
+    char *list_buf;
+    struct otp_session session;
+    u64 start, add_ns, pick_ns, session_ns, list_ns, del_ns;
+    unsigned int i;
+
+    list_buf = kunit_kzalloc(test, OTP_LIST_BUF_SIZE, GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, list_buf);
+
+    start = ktime_get_ns();
+    for (i = 0; i < size; i++) {
+        snprintf(pw, sizeof(pw), "bench%u", i);
+        KUNIT_ASSERT_EQ(test, otp_pool_add(pool, pw), 0);
+        if (!(i & 0xffff))
+            cond_resched();
+    }
+    add_ns = ktime_get_ns() - start;
+
+    start = ktime_get_ns();
+    for (i = 0; i < OTP_BENCH_PICKS; i++) {
+        KUNIT_ASSERT_GT(test, otp_pool_pick(pool, buf, sizeof(buf)), (size_t)0);
+        cond_resched();
+    }
+    pick_ns = ktime_get_ns() - start;
+
+    start = ktime_get_ns();
+    otp_pool_list(pool, list_buf, OTP_LIST_BUF_SIZE);
+    list_ns = ktime_get_ns() - start;
+
+    // pire cas de OTP_IOC_DEL : la dernière entrée, toute la liste est parcourue
+    snprintf(pw, sizeof(pw), "bench%u", size - 1);
+    start = ktime_get_ns();
+    KUNIT_EXPECT_EQ(test, otp_pool_del(pool, pw), 1);
+    del_ns = ktime_get_ns() - start;
+
+    // même tirage depuis une session réservant le pool (dans la limite de OTP_SESSION_MAX)
+    otp_session_init(&session, pool);
+    KUNIT_EXPECT_GT(test, otp_session_reserve(&session, size), 0);
+    start = ktime_get_ns();
+    for (i = 0; i < OTP_BENCH_PICKS; i++)
+        otp_session_pick(&session, buf, sizeof(buf));
+    session_ns = ktime_get_ns() - start;
+    otp_session_release(&session);
+
+    kunit_info(test, "%u entries: add %llu ns/op, pick %llu ns/op, session pick %llu ns/op, list %llu ns, del(tail) %llu ns\n",
+               size, div_u64(add_ns, size), div_u64(pick_ns, OTP_BENCH_PICKS),
+               div_u64(session_ns, OTP_BENCH_PICKS), list_ns, del_ns);
+}
+
+static struct kunit_case otp_list_test_cases[] = {
+    KUNIT_CASE(otp_test_add_basic),
+    KUNIT_CASE(otp_test_add_truncates),
+    KUNIT_CASE(otp_test_add_empty),
+    KUNIT_CASE(otp_test_del),
+    KUNIT_CASE(otp_test_list_empty),
+    KUNIT_CASE(otp_test_list_truncation),
+    KUNIT_CASE(otp_test_list_small_buffer),
+    KUNIT_CASE(otp_test_pick_empty),
+    KUNIT_CASE(otp_test_pick_single),
+    KUNIT_CASE(otp_test_pick_random),
+    KUNIT_CASE(otp_test_pick_truncated_buffer),
+    KUNIT_CASE(otp_test_session_reserve),
+    KUNIT_CASE(otp_test_session_pick),
+    KUNIT_CASE(otp_test_session_revoke),
+    KUNIT_CASE_PARAM_ATTR(otp_bench_pool, otp_bench_gen_params, { .speed = KUNIT_SPEED_SLOW }),
+    {}
+};
+
+static struct kunit_suite otp_list_test_suite = {
+    .name = "otp_list",
+    .init = otp_list_test_init,
+    .exit = otp_list_test_exit,
+    .test_cases = otp_list_test_cases,
+};
+
+kunit_test_suite(otp_list_test_suite);
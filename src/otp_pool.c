@@ -0,0 +1,240 @@
+#include "otp_pool.h"
+
+// Initialise la liste et le mutex d'un pool
+void otp_pool_init(struct otp_pool *pool) {
+    INIT_LIST_HEAD(&pool->otp_list_head);
+    INIT_LIST_HEAD(&pool->sessions);
+    mutex_init(&pool->list_mutex);
+}
+
+// Ajoute un mot de passe en fin de liste (tronqué à 31 caractères)
+int otp_pool_add(struct otp_pool *pool, const char *password) {
+    struct otp_entry *new_entry;
+
+    new_entry = kmalloc(sizeof(*new_entry), GFP_KERNEL);
+    if (!new_entry)
+        return -ENOMEM;
+
+    strncpy(new_entry->password, password, sizeof(new_entry->password) - 1);
+    new_entry->password[sizeof(new_entry->password) - 1] = '\0';
+    new_entry->revoked = false;
+
+    mutex_lock(&pool->list_mutex);
+    list_add_tail(&new_entry->list, &pool->otp_list_head);
+    mutex_unlock(&pool->list_mutex);
+
+    return 0;
+}
+
+// Supprime la première occurrence du mot de passe, retourne 1 si trouvée.
+// Une entrée réservée par une session est révoquée : elle n'est plus tirée et
+// sera libérée à la fermeture de la session au lieu de revenir dans le pool.
+int otp_pool_del(struct otp_pool *pool, const char *password) {
+    struct otp_entry *entry, *tmp;
+    struct otp_session *session;
+    unsigned int i;
+    int removed = 0;
+
+    mutex_lock(&pool->list_mutex);
+    list_for_each_entry_safe(entry, tmp, &pool->otp_list_head, list) {
+        if (strncmp(entry->password, password, sizeof(entry->password)) == 0) {
+            list_del(&entry->list);
+            kfree(entry);
+            removed = 1;
+            break;
+        }
+    }
+
+    // les sessions de pool->sessions ne changent pas tant que le mutex est tenu
+    list_for_each_entry(session, &pool->sessions, node) {
+        if (removed)
+            break;
+        for (i = 0; i < session->count; i++) {
+            entry = session->entries[i];
+            if (!entry->revoked &&
+                strncmp(entry->password, password, sizeof(entry->password)) == 0) {
+                WRITE_ONCE(entry->revoked, true);
+                removed = 1;
+                break;
+            }
+        }
+    }
+    mutex_unlock(&pool->list_mutex);
+
+    return removed;
+}
+
+// Écrit les mots de passe séparés par '\n' dans buf, sans jamais couper une ligne
+size_t otp_pool_list(struct otp_pool *pool, char *buf, size_t size) {
+    struct otp_entry *e;
+    size_t pos = 0;
+
+    mutex_lock(&pool->list_mutex);
+    list_for_each_entry(e, &pool->otp_list_head, list) {
+        int n = snprintf(buf + pos, size - pos, "%s\n", e->password);
+        if (n < 0 || n >= (int)(size - pos))
+            break;
+        pos += n;
+    }
+    mutex_unlock(&pool->list_mutex);
+
+    return pos;
+}
+
+// Copie un mot de passe choisi aléatoirement dans buf, retourne 0 si la liste est vide
+size_t otp_pool_pick(struct otp_pool *pool, char *buf, size_t size) {
+    struct otp_entry *entry;
+    size_t otp_len;
+    unsigned int count = 0;
+    unsigned int random_index;
+    unsigned int i = 0;
+
+    mutex_lock(&pool->list_mutex);
+
+    if (list_empty(&pool->otp_list_head)) {
+        mutex_unlock(&pool->list_mutex);
+        return 0;
+    }
+
+    // Compter le nombre d'entrées
+    list_for_each_entry(entry, &pool->otp_list_head, list) {
+        count++;
+    }
+
+    // Générer un index aléatoire uniforme dans [0, count)
+    random_index = get_random_u32_below(count);
+
+    // Trouver l'entrée correspondant à random_index
+    list_for_each_entry(entry, &pool->otp_list_head, list) {
+        if (i == random_index)
+            break;
+        i++;
+    }
+
+    // Copier le mot de passe dans le buffer
+    otp_len = snprintf(buf, size, "%s\n", entry->password);
+
+    mutex_unlock(&pool->list_mutex);
+
+    return otp_len;
+}
+
+// Libère toutes les entrées du pool
+void otp_pool_clear(struct otp_pool *pool) {
+    struct otp_entry *entry, *tmp;
+
+    mutex_lock(&pool->list_mutex);
+    list_for_each_entry_safe(entry, tmp, &pool->otp_list_head, list) {
+        list_del(&entry->list);
+        kfree(entry);
+    }
+    mutex_unlock(&pool->list_mutex);
+}
+
+void otp_session_init(struct otp_session *session, struct otp_pool *pool) {
+    session->pool = pool;
+    session->entries = NULL;
+    session->count = 0;
+    session->reserved = 0;
+    INIT_LIST_HEAD(&session->node);
+}
+
+// Déplace jusqu'à count entrées de la tête du pool vers la session et retourne
+// le nombre d'entrées réservées, ou -EBUSY si la session a déjà sa réserve
+int otp_session_reserve(struct otp_session *session, unsigned int count) {
+    struct otp_pool *pool = session->pool;
+    struct otp_entry **entries;
+    struct otp_entry *entry, *tmp;
+    unsigned int reserved = 0;
+
+    if (count == 0)
+        return 0;
+    if (count > OTP_SESSION_MAX)
+        count = OTP_SESSION_MAX;
+
+    // un seul appel peut remplir la session, même si le fichier est partagé
+    if (cmpxchg(&session->reserved, 0, 1) != 0)
+        return -EBUSY;
+
+    // alloué hors du mutex, à la taille maximale possible
+    entries = kvmalloc_array(count, sizeof(*entries), GFP_KERNEL);
+    if (!entries) {
+        smp_store_release(&session->reserved, 0);
+        return -ENOMEM;
+    }
+
+    mutex_lock(&pool->list_mutex);
+    list_for_each_entry_safe(entry, tmp, &pool->otp_list_head, list) {
+        if (reserved == count)
+            break;
+        list_del(&entry->list);
+        entries[reserved++] = entry;
+    }
+    if (reserved) {
+        session->entries = entries;
+        list_add_tail(&session->node, &pool->sessions);
+        // entries est complet avant que count ne devienne visible aux lectures
+        smp_store_release(&session->count, reserved);
+    }
+    mutex_unlock(&pool->list_mutex);
+
+    // pool vide : rien n'a été publié, la session peut réessayer plus tard
+    if (!reserved) {
+        kvfree(entries);
+        smp_store_release(&session->reserved, 0);
+    }
+
+    return reserved;
+}
+
+// Comme otp_pool_pick, mais en O(1) et sans verrou : la réserve est immuable
+// une fois publiée. Retourne 0 si la session est vide ou entièrement révoquée.
+size_t otp_session_pick(struct otp_session *session, char *buf, size_t size) {
+    unsigned int count = smp_load_acquire(&session->count);
+    unsigned int start, i;
+    struct otp_entry *entry;
+
+    if (count == 0)
+        return 0;
+
+    // un nouveau tirage sur une entrée révoquée garde la loi uniforme sur les
+    // entrées restantes ; le parcours linéaire ne sert que si presque tout est révoqué
+    for (i = 0; i < OTP_SESSION_RETRIES; i++) {
+        entry = session->entries[get_random_u32_below(count)];
+        if (!READ_ONCE(entry->revoked))
+            return snprintf(buf, size, "%s\n", entry->password);
+    }
+
+    start = get_random_u32_below(count);
+    for (i = 0; i < count; i++) {
+        entry = session->entries[(start + i) % count];
+        if (!READ_ONCE(entry->revoked))
+            return snprintf(buf, size, "%s\n", entry->password);
+    }
+
+    return 0;
+}
+
+// Rend les entrées réservées au pool (en fin de liste) et libère celles qui ont
+// été révoquées. Appelé à la fermeture du fichier, quand plus personne ne lit.
+void otp_session_release(struct otp_session *session) {
+    struct otp_pool *pool = session->pool;
+    unsigned int i;
+
+    if (session->count) {
+        mutex_lock(&pool->list_mutex);
+        list_del_init(&session->node);
+        for (i = 0; i < session->count; i++) {
+            if (session->entries[i]->revoked)
+                kfree(session->entries[i]);
+            else
+                list_add_tail(&session->entries[i]->list, &pool->otp_list_head);
+        }
+        mutex_unlock(&pool->list_mutex);
+    }
+
+    kvfree(session->entries);
+    session->entries = NULL;
+    session->count = 0;
+    session->reserved = 0;
+}
@@ -0,0 +1,47 @@
+#ifndef OTP_POOL_H
+#define OTP_POOL_H
+
+#include "otp_compat.h"
+
+#define OTP_LIST_BUF_SIZE 1024 // taille max de la réponse à OTP_IOC_LIST
+#define OTP_SESSION_MAX 65536  // entrées réservables au plus par une session
+#define OTP_SESSION_RETRIES 16 // tirages sur une entrée révoquée avant le parcours linéaire
+
+struct otp_entry {
+    char password[32];
+    struct list_head list;
+    bool revoked; // supprimé par OTP_IOC_DEL pendant qu'une session le réservait
+};
+
+// Liste de mots de passe d'un périphérique et sessions ayant réservé des
+// entrées, protégées par le même mutex
+struct otp_pool {
+    struct list_head otp_list_head;
+    struct list_head sessions;
+    struct mutex list_mutex;
+};
+
+// Réserve privée d'un fichier ouvert. Elle est remplie une seule fois puis ne
+// change plus jusqu'à la fermeture du fichier : les lectures la parcourent sans
+// verrou, même si le fichier est partagé (threads, dup, fork).
+struct otp_session {
+    struct otp_pool *pool;
+    struct otp_entry **entries;
+    unsigned int count;    // publié par smp_store_release une fois entries rempli
+    int reserved;          // 1 dès qu'un OTP_IOC_RESERVE a été accepté
+    struct list_head node; // dans pool->sessions tant que count > 0
+};
+
+void otp_pool_init(struct otp_pool *pool);
+int otp_pool_add(struct otp_pool *pool, const char *password);
+int otp_pool_del(struct otp_pool *pool, const char *password);
+size_t otp_pool_list(struct otp_pool *pool, char *buf, size_t size);
+size_t otp_pool_pick(struct otp_pool *pool, char *buf, size_t size);
+void otp_pool_clear(struct otp_pool *pool);
+
+void otp_session_init(struct otp_session *session, struct otp_pool *pool);
+int otp_session_reserve(struct otp_session *session, unsigned int count);
+size_t otp_session_pick(struct otp_session *session, char *buf, size_t size);
+void otp_session_release(struct otp_session *session);
+
+#endif
@@ -3,17 +3,14 @@
 #include <linux/fs.h>
 #include <linux/cdev.h>
 #include <linux/uaccess.h>
-#include <linux/list.h>
-#include <linux/slab.h>
 #include <linux/mutex.h>
 #include <linux/ioctl.h>
 #include <linux/device.h>
 #include <linux/string.h>
 #include <linux/jiffies.h> // pour le temps
 #include <linux/ktime.h>
-#include <linux/random.h>
-#include <linux/crypto.h>
-#include <crypto/hash.h> // pour le HMAC
+
+#include "otp_totp.h"
 
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("Xavier, Eleonore, Alexis");
@@ -27,9 +24,6 @@ MODULE_VERSION("1.0");
 #define OTP_IOC_MAGIC 'k'
 #define OTP_IOC_SET_KEY _IOW(OTP_IOC_MAGIC, 1, char *)
 #define OTP_IOC_SET_DURATION _IOW(OTP_IOC_MAGIC, 2, int)
-#define OTP_DIGITS 6
-#define OTP_DIGITS_POWTEN 1000000 // pow(10, OTP_DIGITS) : 1 et six 0
-#define SHA1_DIGEST_SIZE 20
 
 static dev_t dev_num_base;
 static struct class* timeotp_class = NULL;
@@ -59,58 +53,6 @@ static int timeotp_release(struct inode *inode, struct file *filep) {
     return 0;
 }
 
-// dynamic truncation de la méthode HOTP de la RFC 4226
-static unsigned int truncate_to_otp(const unsigned char *hash, size_t hash_len) {
-    // dynamic offset = 4 bits du bas
-    unsigned int offset = hash[hash_len - 1] & 0x0F;
-    unsigned int binary =
-        ((hash[offset] & 0x7F) << 24) |
-        ((hash[offset + 1] & 0xFF) << 16) |
-        ((hash[offset + 2] & 0xFF) << 8) |
-        (hash[offset + 3] & 0xFF);
-    return binary % OTP_DIGITS_POWTEN; // tronque à OTP_DIGITS
-}
-
-static void generate_time_otp(struct timeotp_device *dev, char *buf, size_t size) {
-    u64 now = ktime_get_real_seconds();
-    u64 slot = now / (dev->duration ? dev->duration : 30); // défaut: 30 secondes
-    unsigned char digest[SHA1_DIGEST_SIZE];
-
-    struct crypto_shash *tfm;
-    struct shash_desc *shash;
-
-    // contexte crypto
-    tfm = crypto_alloc_shash("hmac(sha1)", 0, 0);
-    if (IS_ERR(tfm)) {
-        snprintf(buf, size, "ERROR\n");
-        return;
-    }
-
-    // alloue de l'espace pour hashing
-    shash = kmalloc(sizeof(*shash) + crypto_shash_descsize(tfm), GFP_KERNEL);
-    if (!shash) {
-        crypto_free_shash(tfm);
-        snprintf(buf, size, "ERROR\n");
-        return;
-    }
-
-    shash->tfm = tfm;
-
-    // calcule le HMAC-SHA-1(slot, key) puis tronque avec la méthode HOTP de la RFC 4226
-    if (crypto_shash_setkey(tfm, dev->key, strlen(dev->key)) == 0 &&
-        crypto_shash_init(shash) == 0 &&
-        crypto_shash_update(shash, (u8 *)&slot, sizeof(slot)) == 0 &&
-        crypto_shash_final(shash, digest) == 0) {
-        unsigned int otp = truncate_to_otp(digest, SHA1_DIGEST_SIZE);
-        snprintf(buf, size, "%0*u\n", OTP_DIGITS, otp); // formate l'OTP à OTP_DIGITS de longueur
-    } else {
-        snprintf(buf, size, "ERROR\n");
-    }
-
-    kfree(shash);
-    crypto_free_shash(tfm);
-}
-
 static ssize_t timeotp_read(struct file *filep, char __user *buffer, size_t len, loff_t *offset) {
     struct timeotp_device *dev = filep->private_data;
     char otp_buf[64];
@@ -119,7 +61,7 @@ static ssize_t timeotp_read(struct file *filep, char __user *buffer, size_t len,
         return 0;
 
     mutex_lock(&dev->lock);
-    generate_time_otp(dev, otp_buf, sizeof(otp_buf));
+    generate_time_otp(dev->key, dev->duration, ktime_get_real_seconds(), otp_buf, sizeof(otp_buf));
     mutex_unlock(&dev->lock);
 
     size_t otp_len = strnlen(otp_buf, sizeof(otp_buf));
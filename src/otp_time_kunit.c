@@ -0,0 +1,185 @@
+// Tests KUnit du cœur TOTP de otp_time, liés au module avec make KUNIT=1
+#include <kunit/test.h>
+#include <linux/ktime.h>
+#include <linux/kernel.h> // hex2bin
+#include <asm/byteorder.h>
+
+#include "otp_totp.h"
+
+#define OTP_BENCH_HMAC_ITERS 10000
+
+// secret commun aux annexes de la RFC 4226 et de la RFC 6238 (SHA-1)
+static const char rfc_secret[] = "12345678901234567890";
+
+struct hotp_vector {
+    const char *hmac_hex;
+    unsigned int otp;
+};
+
+// RFC 4226, annexe D : HMAC-SHA-1(secret, count) pour count = 0..9
+static const struct hotp_vector rfc4226_vectors[] = {
+    { "cc93cf18508d94934c64b65d8ba7667fb7cde4b0", 755224 },
+    { "75a48a19d4cbe100644e8ac1397eea747a2d33ab", 287082 },
+    { "0bacb7fa082fef30782211938bc1c5e70416ff44", 359152 },
+    { "66c28227d03a2d5529262ff016a1e6ef76557ece", 969429 },
+    { "a904c900a64b35909874b33e61c5938a8e15ed1c", 338314 },
+    { "a37e783d7b7233c083d4f62926c7a25f238d0316", 254676 },
+    { "bc9cd28561042c83f219324d3c607256c03272ae", 287922 },
+    { "a4fb960c0bc06e1eabb804e5b397cdc4b45596fa", 162583 },
+    { "1b3c89f65e6c9e883012052823443f048b4332db", 399871 },
+    { "1637409809a679dc698207310c8c7fc07290d9e5", 520489 },
+};
+
+struct totp_vector {
+    u64 time;
+    unsigned int otp; // valeur à 8 chiffres de la RFC, tronquée à OTP_DIGITS
+};
+
+// RFC 6238, annexe B (SHA-1, pas de 30 secondes)
+static const struct totp_vector rfc6238_vectors[] = {
+    { 59ULL, 94287082 },
+    { 1111111109ULL, 7081804 },
+    { 1111111111ULL, 14050471 },
+    { 1234567890ULL, 89005924 },
+    { 2000000000ULL, 69279037 },
+    { 20000000000ULL, 65353130 },
+};
+
+static void timeotp_test_truncate_rfc4226(struct kunit *test) {
+    unsigned char digest[SHA1_DIGEST_SIZE];
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(rfc4226_vectors); i++) {
+        KUNIT_ASSERT_EQ(test, hex2bin(digest, rfc4226_vectors[i].hmac_hex, SHA1_DIGEST_SIZE), 0);
+        KUNIT_EXPECT_EQ_MSG(test, truncate_to_otp(digest, SHA1_DIGEST_SIZE),
+                            rfc4226_vectors[i].otp, "count %d", i);
+    }
+}
+
+static void timeotp_test_truncate_offsets(struct kunit *test) {
+    unsigned char digest[SHA1_DIGEST_SIZE];
+
+    // offset maximal (15) : lit les octets 15 à 18, le bit de poids fort est masqué
+    memset(digest, 0, sizeof(digest));
+    digest[15] = 0xff;
+    digest[16] = 0xff;
+    digest[17] = 0xff;
+    digest[18] = 0xff;
+    digest[19] = 0x0f;
+    KUNIT_EXPECT_EQ(test, truncate_to_otp(digest, SHA1_DIGEST_SIZE), 0x7fffffffU % OTP_DIGITS_POWTEN);
+
+    // offset 0
+    memset(digest, 0, sizeof(digest));
+    digest[3] = 42;
+    KUNIT_EXPECT_EQ(test, truncate_to_otp(digest, SHA1_DIGEST_SIZE), 42U);
+}
+
+// Sortie réelle du périphérique : generate_time_otp hache le créneau dans
+// l'ordre d'octets natif, et non en big-endian comme la RFC 6238. Sur une
+// machine little-endian (x86), /dev/timeotp0 ne donne donc pas les codes RFC.
+static const unsigned int timeotp_device_otps[] = {
+#ifdef __LITTLE_ENDIAN
+    160385, 110502, 133078, 98333, 187810, 188580,
+#else
+    94287082 % OTP_DIGITS_POWTEN, 7081804 % OTP_DIGITS_POWTEN,
+    14050471 % OTP_DIGITS_POWTEN, 89005924 % OTP_DIGITS_POWTEN,
+    69279037 % OTP_DIGITS_POWTEN, 65353130 % OTP_DIGITS_POWTEN,
+#endif
+};
+
+static void timeotp_test_hotp_rfc4226(struct kunit *test) {
+    unsigned int otp;
+    __be64 counter;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(rfc4226_vectors); i++) {
+        counter = cpu_to_be64(i);
+        KUNIT_ASSERT_EQ(test, timeotp_hmac_otp(rfc_secret, strlen(rfc_secret),
+                                               (u8 *)&counter, sizeof(counter), &otp), 0);
+        KUNIT_EXPECT_EQ_MSG(test, otp, rfc4226_vectors[i].otp, "count %d", i);
+    }
+}
+
+static void timeotp_test_totp_rfc6238(struct kunit *test) {
+    unsigned int otp;
+    __be64 counter;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(rfc6238_vectors); i++) {
+        counter = cpu_to_be64(timeotp_slot(rfc6238_vectors[i].time, 30));
+        KUNIT_ASSERT_EQ(test, timeotp_hmac_otp(rfc_secret, strlen(rfc_secret),
+                                               (u8 *)&counter, sizeof(counter), &otp), 0);
+        KUNIT_EXPECT_EQ_MSG(test, otp, rfc6238_vectors[i].otp % OTP_DIGITS_POWTEN,
+                            "T = %llu", rfc6238_vectors[i].time);
+    }
+}
+
+static void timeotp_test_generate_device(struct kunit *test) {
+    char buf[64], expected[16];
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(rfc6238_vectors); i++) {
+        generate_time_otp(rfc_secret, 30, rfc6238_vectors[i].time, buf, sizeof(buf));
+        snprintf(expected, sizeof(expected), "%0*u\n", OTP_DIGITS, timeotp_device_otps[i]);
+        KUNIT_EXPECT_STREQ_MSG(test, buf, expected, "T = %llu", rfc6238_vectors[i].time);
+    }
+}
+
+static void timeotp_test_slot(struct kunit *test) {
+    KUNIT_EXPECT_EQ(test, timeotp_slot(59, 30), 1ULL);
+    KUNIT_EXPECT_EQ(test, timeotp_slot(60, 30), 2ULL);
+    KUNIT_EXPECT_EQ(test, timeotp_slot(119, 60), 1ULL);
+    // durée nulle : défaut de 30 secondes
+    KUNIT_EXPECT_EQ(test, timeotp_slot(59, 0), 1ULL);
+}
+
+static void timeotp_test_generate_format(struct kunit *test) {
+    char buf[64];
+    int i;
+
+    generate_time_otp(rfc_secret, 30, ktime_get_real_seconds(), buf, sizeof(buf));
+    KUNIT_ASSERT_EQ(test, strlen(buf), (size_t)OTP_DIGITS + 1);
+    for (i = 0; i < OTP_DIGITS; i++)
+        KUNIT_EXPECT_TRUE(test, buf[i] >= '0' && buf[i] <= '9');
+    KUNIT_EXPECT_EQ(test, buf[OTP_DIGITS], '\n');
+}
+
+// Microbenchmark du chemin de génération (allocation tfm + HMAC + troncature)
+static void timeotp_bench_hmac(struct kunit *test) {
+    unsigned int otp;
+    u64 start, elapsed;
+    u64 slot;
+    int i;
+
+    start = ktime_get_ns();
+    for (i = 0; i < OTP_BENCH_HMAC_ITERS; i++) {
+        slot = i;
+        KUNIT_ASSERT_EQ(test, timeotp_hmac_otp(rfc_secret, strlen(rfc_secret),
+                                               (u8 *)&slot, sizeof(slot), &otp), 0);
+        if (!(i & 0xff))
+            cond_resched();
+    }
+    elapsed = ktime_get_ns() - start;
+
+    kunit_info(test, "hmac(sha1) otp: %llu ns/op over %d iterations\n",
+               div_u64(elapsed, OTP_BENCH_HMAC_ITERS), OTP_BENCH_HMAC_ITERS);
+}
+
+static struct kunit_case timeotp_test_cases[] = {
+    KUNIT_CASE(timeotp_test_truncate_rfc4226),
+    KUNIT_CASE(timeotp_test_truncate_offsets),
+    KUNIT_CASE(timeotp_test_hotp_rfc4226),
+    KUNIT_CASE(timeotp_test_totp_rfc6238),
+    KUNIT_CASE(timeotp_test_generate_device),
+    KUNIT_CASE(timeotp_test_slot),
+    KUNIT_CASE(timeotp_test_generate_format),
+    KUNIT_CASE_SLOW(timeotp_bench_hmac),
+    {}
+};
+
+static struct kunit_suite timeotp_test_suite = {
+    .name = "otp_time",
+    .test_cases = timeotp_test_cases,
+};
+
+kunit_test_suite(timeotp_test_suite);
@@ -0,0 +1,66 @@
+#include "otp_totp.h"
+
+// dynamic truncation de la méthode HOTP de la RFC 4226
+unsigned int truncate_to_otp(const unsigned char *hash, size_t hash_len) {
+    // dynamic offset = 4 bits du bas
+    unsigned int offset = hash[hash_len - 1] & 0x0F;
+    unsigned int binary =
+        ((hash[offset] & 0x7F) << 24) |
+        ((hash[offset + 1] & 0xFF) << 16) |
+        ((hash[offset + 2] & 0xFF) << 8) |
+        (hash[offset + 3] & 0xFF);
+    return binary % OTP_DIGITS_POWTEN; // tronque à OTP_DIGITS
+}
+
+// numéro de créneau temporel T = now / durée (défaut: 30 secondes)
+u64 timeotp_slot(u64 now, int duration) {
+    return now / (duration ? duration : 30);
+}
+
+// calcule HMAC-SHA-1(msg, key) puis tronque avec la méthode HOTP de la RFC 4226
+int timeotp_hmac_otp(const char *key, size_t key_len,
+                     const u8 *msg, size_t msg_len, unsigned int *otp) {
+    unsigned char digest[SHA1_DIGEST_SIZE];
+    struct crypto_shash *tfm;
+    struct shash_desc *shash;
+    int ret;
+
+    // contexte crypto
+    tfm = crypto_alloc_shash("hmac(sha1)", 0, 0);
+    if (IS_ERR(tfm))
+        return PTR_ERR(tfm);
+
+    // alloue de l'espace pour hashing
+    shash = kmalloc(sizeof(*shash) + crypto_shash_descsize(tfm), GFP_KERNEL);
+    if (!shash) {
+        crypto_free_shash(tfm);
+        return -ENOMEM;
+    }
+
+    shash->tfm = tfm;
+
+    ret = crypto_shash_setkey(tfm, (const u8 *)key, key_len);
+    if (!ret)
+        ret = crypto_shash_init(shash);
+    if (!ret)
+        ret = crypto_shash_update(shash, msg, msg_len);
+    if (!ret)
+        ret = crypto_shash_final(shash, digest);
+    if (!ret)
+        *otp = truncate_to_otp(digest, SHA1_DIGEST_SIZE);
+
+    kfree(shash);
+    crypto_free_shash(tfm);
+    return ret;
+}
+
+// formate l'OTP courant ("%06u\n"), ou "ERROR\n" si le HMAC échoue
+void generate_time_otp(const char *key, int duration, u64 now, char *buf, size_t size) {
+    u64 slot = timeotp_slot(now, duration);
+    unsigned int otp;
+
+    if (timeotp_hmac_otp(key, strlen(key), (u8 *)&slot, sizeof(slot), &otp) == 0)
+        snprintf(buf, size, "%0*u\n", OTP_DIGITS, otp); // formate l'OTP à OTP_DIGITS de longueur
+    else
+        snprintf(buf, size, "ERROR\n");
+}
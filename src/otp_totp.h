@@ -0,0 +1,16 @@
+#ifndef OTP_TOTP_H
+#define OTP_TOTP_H
+
+#include "otp_compat.h"
+
+#define OTP_DIGITS 6
+#define OTP_DIGITS_POWTEN 1000000 // pow(10, OTP_DIGITS) : 1 et six 0
+#define SHA1_DIGEST_SIZE 20
+
+unsigned int truncate_to_otp(const unsigned char *hash, size_t hash_len);
+u64 timeotp_slot(u64 now, int duration);
+int timeotp_hmac_otp(const char *key, size_t key_len,
+                     const u8 *msg, size_t msg_len, unsigned int *otp);
+void generate_time_otp(const char *key, int duration, u64 now, char *buf, size_t size);
+
+#endif
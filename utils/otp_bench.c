@@ -0,0 +1,522 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define DEFAULT_DEVICE "/dev/otpdev0"
+
+#define OTP_IOC_MAGIC 'k'
+#define OTP_IOC_ADD _IOW(OTP_IOC_MAGIC, 1, char *)
+#define OTP_IOC_DEL _IOW(OTP_IOC_MAGIC, 2, char *)
+#define OTP_IOC_LIST _IOR(OTP_IOC_MAGIC, 3, char *)
+#define OTP_IOC_RESERVE _IOW(OTP_IOC_MAGIC, 4, int)
+
+#define MAX_SWEEP 32
+#define MAX_OWNED 4096 // mots de passe ajoutés par un worker en attente de suppression (anneau)
+
+enum op_type { OP_GET, OP_ADD, OP_DEL, OP_LIST, OP_COUNT };
+
+static const char *op_names[OP_COUNT] = { "get", "add", "del", "list" };
+
+struct bench_config {
+    const char *device;
+    int timeotp;             // /dev/timeotp0 : seul "get" est supporté
+    int use_processes;
+    int sweep[MAX_SWEEP];
+    int sweep_len;
+    long ops;                // opérations par worker
+    int batch;               // opérations par échantillon de latence
+    int pool_size;           // mots de passe pré-remplis
+    int reserve;             // entrées réservées par worker (session, get sans verrou)
+    unsigned int mix[OP_COUNT];
+    unsigned int mix_total;
+};
+
+// Un échantillon = un lot de `batch` opérations du même type
+struct sample {
+    uint64_t ns_per_op;
+    int op;
+};
+
+// Zone partagée entre le processus principal et les workers (threads ou fork)
+struct shared_state {
+    volatile int go;
+    uint64_t start_ns[1024];
+    uint64_t end_ns[1024];
+    long errors[1024];
+    int reserved[1024];      // retour de OTP_IOC_RESERVE, par worker
+};
+
+// Ajouts d'un worker pas encore supprimés, du plus ancien (head) au plus récent
+struct owned_ring {
+    char (*names)[32];
+    int head;
+    int count;
+};
+
+struct worker_ctx {
+    const struct bench_config *cfg;
+    struct shared_state *shared;
+    struct sample *samples; // cfg->ops / cfg->batch échantillons
+    int id;
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int pick_op(const struct bench_config *cfg, unsigned int *seed) {
+    unsigned int r = rand_r(seed) % cfg->mix_total;
+    int op;
+
+    for (op = 0; op < OP_COUNT; op++) {
+        if (r < cfg->mix[op])
+            return op;
+        r -= cfg->mix[op];
+    }
+    return OP_GET;
+}
+
+static int do_op(int fd, int op, int id, long *seq, struct owned_ring *owned) {
+    char buffer[1024];
+    char password[32];
+    int ret = 0;
+
+    switch (op) {
+        case OP_GET:
+            // pread à l'offset 0 : otp_read ne répond qu'une fois par offset
+            return pread(fd, buffer, 64, 0) < 0 ? -1 : 0;
+
+        case OP_ADD:
+            // anneau plein : supprime d'abord l'ajout le plus ancien pour que
+            // chaque ADD reste suivi et le pool borné (coût compté dans l'add)
+            if (owned->count == MAX_OWNED) {
+                if (ioctl(fd, OTP_IOC_DEL, owned->names[owned->head]) < 0)
+                    ret = -1;
+                owned->head = (owned->head + 1) % MAX_OWNED;
+                owned->count--;
+            }
+            snprintf(password, sizeof(password), "w%d_%ld", id, (*seq)++);
+            if (ioctl(fd, OTP_IOC_ADD, password) < 0)
+                return -1;
+            memcpy(owned->names[(owned->head + owned->count++) % MAX_OWNED], password, sizeof(password));
+            return ret;
+
+        case OP_DEL:
+            // supprime le dernier ajout du worker, sinon un nom absent (parcours complet)
+            if (owned->count > 0)
+                memcpy(password, owned->names[(owned->head + --owned->count) % MAX_OWNED], sizeof(password));
+            else
+                snprintf(password, sizeof(password), "absent_%d", id);
+            return ioctl(fd, OTP_IOC_DEL, password) < 0 ? -1 : 0;
+
+        case OP_LIST:
+            return ioctl(fd, OTP_IOC_LIST, buffer) < 0 ? -1 : 0;
+    }
+    return -1;
+}
+
+static void run_worker(struct worker_ctx *ctx) {
+    const struct bench_config *cfg = ctx->cfg;
+    struct owned_ring owned = { 0 };
+    unsigned int seed = 0x9e3779b9u ^ (unsigned int)ctx->id;
+    long n_samples = cfg->ops / cfg->batch;
+    long seq = 0;
+    long s;
+    int fd, b;
+
+    owned.names = malloc(MAX_OWNED * sizeof(*owned.names));
+    fd = open(cfg->device, O_RDWR);
+    if (!owned.names || fd < 0) {
+        perror("Erreur ouverture périphérique");
+        ctx->shared->errors[ctx->id] = cfg->ops;
+        if (fd >= 0)
+            close(fd);
+        free(owned.names);
+        return;
+    }
+
+    // la réservation se fait une fois, hors mesure ; release la rend au pool.
+    // Le pool peut en fournir moins que demandé : le nombre obtenu est rapporté.
+    if (cfg->reserve > 0) {
+        int ret = ioctl(fd, OTP_IOC_RESERVE, &cfg->reserve);
+        if (ret < 0)
+            perror("Erreur réservation");
+        else
+            ctx->shared->reserved[ctx->id] = ret;
+    }
+
+    while (!__atomic_load_n(&ctx->shared->go, __ATOMIC_ACQUIRE))
+        ;
+
+    ctx->shared->start_ns[ctx->id] = now_ns();
+    for (s = 0; s < n_samples; s++) {
+        int op = pick_op(cfg, &seed);
+        uint64_t t0 = now_ns();
+
+        for (b = 0; b < cfg->batch; b++) {
+            if (do_op(fd, op, ctx->id, &seq, &owned) < 0)
+                ctx->shared->errors[ctx->id]++;
+        }
+        ctx->samples[s].ns_per_op = (now_ns() - t0) / cfg->batch;
+        ctx->samples[s].op = op;
+    }
+    ctx->shared->end_ns[ctx->id] = now_ns();
+
+    // rend le pool dans son état initial
+    while (owned.count > 0)
+        ioctl(fd, OTP_IOC_DEL, owned.names[(owned.head + --owned.count) % MAX_OWNED]);
+
+    free(owned.names);
+    close(fd);
+}
+
+static void *worker_thread(void *arg) {
+    run_worker(arg);
+    return NULL;
+}
+
+static int cmp_sample(const void *a, const void *b) {
+    uint64_t x = ((const struct sample *)a)->ns_per_op;
+    uint64_t y = ((const struct sample *)b)->ns_per_op;
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(const struct sample *sorted, long n, double p) {
+    long idx;
+
+    if (n == 0)
+        return 0.0;
+    idx = (long)(p * (double)(n - 1) + 0.5);
+    return sorted[idx].ns_per_op / 1000.0;
+}
+
+static void report(const struct bench_config *cfg, int workers, struct sample *samples,
+                   long n_samples, uint64_t wall_ns, long errors, long reserved, int short_reserve) {
+    struct sample *by_op;
+    long n_op;
+    int op;
+    long i;
+
+    qsort(samples, n_samples, sizeof(*samples), cmp_sample);
+
+    printf("%-8d %12.0f %10.2f %10.2f %10.2f %8ld\n",
+           workers,
+           (double)n_samples * cfg->batch / ((double)wall_ns / 1e9),
+           percentile_us(samples, n_samples, 0.50),
+           percentile_us(samples, n_samples, 0.99),
+           percentile_us(samples, n_samples, 0.999),
+           errors);
+
+    if (cfg->reserve > 0) {
+        printf("  réservé %ld/%ld entrées", reserved, (long)workers * cfg->reserve);
+        if (short_reserve)
+            printf(" (%d worker(s) sous -r %d : leurs get passent en partie par le mutex)",
+                   short_reserve, cfg->reserve);
+        printf("\n");
+    }
+
+    // détail par type d'opération (les échantillons sont déjà triés)
+    by_op = malloc(n_samples * sizeof(*by_op));
+    if (!by_op)
+        return;
+    for (op = 0; op < OP_COUNT; op++) {
+        if (cfg->mix[op] == 0)
+            continue;
+        n_op = 0;
+        for (i = 0; i < n_samples; i++) {
+            if (samples[i].op == op)
+                by_op[n_op++] = samples[i];
+        }
+        printf("  %-6s %12ld %10.2f %10.2f %10.2f\n", op_names[op], n_op * cfg->batch,
+               percentile_us(by_op, n_op, 0.50),
+               percentile_us(by_op, n_op, 0.99),
+               percentile_us(by_op, n_op, 0.999));
+    }
+    free(by_op);
+}
+
+static int run_bench(const struct bench_config *cfg, int workers) {
+    long n_samples = cfg->ops / cfg->batch;
+    size_t samples_size = (size_t)workers * n_samples * sizeof(struct sample);
+    struct shared_state *shared;
+    struct sample *samples;
+    struct worker_ctx *ctx;
+    pthread_t *threads = NULL;
+    pid_t *pids = NULL;
+    uint64_t first_start = UINT64_MAX, last_end = 0;
+    long errors = 0, reserved = 0;
+    int ran = 0, short_reserve = 0;
+    int ret = 0;
+    int i;
+
+    // mémoire partagée pour que les workers forkés puissent rendre leurs résultats
+    shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    samples = mmap(NULL, samples_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ctx = calloc(workers, sizeof(*ctx));
+    if (cfg->use_processes)
+        pids = calloc(workers, sizeof(*pids));
+    else
+        threads = calloc(workers, sizeof(*threads));
+    if (shared == MAP_FAILED || samples == MAP_FAILED || !ctx || (!pids && !threads)) {
+        perror("Erreur allocation");
+        ret = -1;
+        goto out;
+    }
+
+    for (i = 0; i < workers; i++) {
+        ctx[i].cfg = cfg;
+        ctx[i].shared = shared;
+        ctx[i].samples = samples + (size_t)i * n_samples;
+        ctx[i].id = i;
+    }
+
+    if (cfg->use_processes) {
+        for (i = 0; i < workers; i++) {
+            pids[i] = fork();
+            if (pids[i] == 0) {
+                run_worker(&ctx[i]);
+                _exit(EXIT_SUCCESS);
+            }
+            if (pids[i] < 0) {
+                perror("Erreur fork");
+                workers = i;
+                break;
+            }
+        }
+    } else {
+        for (i = 0; i < workers; i++) {
+            if (pthread_create(&threads[i], NULL, worker_thread, &ctx[i]) != 0) {
+                perror("Erreur création thread");
+                workers = i;
+                break;
+            }
+        }
+    }
+
+    __atomic_store_n(&shared->go, 1, __ATOMIC_RELEASE);
+
+    for (i = 0; i < workers; i++) {
+        if (cfg->use_processes)
+            waitpid(pids[i], NULL, 0);
+        else
+            pthread_join(threads[i], NULL);
+    }
+
+    // seuls les workers qui ont tourné comptent : leurs échantillons sont
+    // regroupés en tête de samples, ceux des autres restent à zéro et sont ignorés
+    for (i = 0; i < workers; i++) {
+        errors += shared->errors[i];
+        if (!shared->start_ns[i])
+            continue;
+        if (shared->start_ns[i] < first_start)
+            first_start = shared->start_ns[i];
+        if (shared->end_ns[i] > last_end)
+            last_end = shared->end_ns[i];
+        reserved += shared->reserved[i];
+        if (shared->reserved[i] < cfg->reserve)
+            short_reserve++;
+        if (ran != i)
+            memmove(samples + (size_t)ran * n_samples, samples + (size_t)i * n_samples,
+                    n_samples * sizeof(*samples));
+        ran++;
+    }
+
+    if (ran > 0 && last_end > first_start) {
+        if (ran < workers)
+            fprintf(stderr, "Attention : %d worker(s) sur %d n'ont pas pu s'exécuter.\n",
+                    workers - ran, workers);
+        report(cfg, ran, samples, (long)ran * n_samples, last_end - first_start, errors,
+               reserved, short_reserve);
+    } else {
+        fprintf(stderr, "Aucun worker n'a pu s'exécuter.\n");
+        ret = -1;
+    }
+
+out:
+    free(threads);
+    free(pids);
+    free(ctx);
+    if (samples != MAP_FAILED)
+        munmap(samples, samples_size);
+    if (shared != MAP_FAILED)
+        munmap(shared, sizeof(*shared));
+    return ret;
+}
+
+static int fill_pool(const struct bench_config *cfg, unsigned long request) {
+    char password[32];
+    int fd, i;
+
+    fd = open(cfg->device, O_RDWR);
+    if (fd < 0) {
+        perror("Erreur ouverture périphérique");
+        return -1;
+    }
+
+    // OTP_IOC_DEL retire la première occurrence : les entrées "pool" sont en tête de liste
+    for (i = 0; i < cfg->pool_size; i++) {
+        snprintf(password, sizeof(password), "pool%d", i);
+        if (ioctl(fd, request, password) < 0) {
+            perror(request == OTP_IOC_ADD ? "Erreur ajout mot de passe" : "Erreur suppression mot de passe");
+            close(fd);
+            return -1;
+        }
+    }
+
+    close(fd);
+    return 0;
+}
+
+static int parse_mix(struct bench_config *cfg, char *arg) {
+    char *tok, *save = NULL;
+    int op;
+
+    memset(cfg->mix, 0, sizeof(cfg->mix));
+    cfg->mix_total = 0;
+
+    for (tok = strtok_r(arg, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(tok, '=');
+        if (!eq)
+            return -1;
+        *eq = '\0';
+        for (op = 0; op < OP_COUNT; op++) {
+            if (strcmp(tok, op_names[op]) == 0)
+                break;
+        }
+        if (op == OP_COUNT)
+            return -1;
+        cfg->mix[op] = (unsigned int)atoi(eq + 1);
+        cfg->mix_total += cfg->mix[op];
+    }
+    return cfg->mix_total > 0 ? 0 : -1;
+}
+
+static int parse_sweep(struct bench_config *cfg, char *arg) {
+    char *tok, *save = NULL;
+
+    cfg->sweep_len = 0;
+    for (tok = strtok_r(arg, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        int n = atoi(tok);
+        if (n <= 0 || n > 1024 || cfg->sweep_len == MAX_SWEEP)
+            return -1;
+        cfg->sweep[cfg->sweep_len++] = n;
+    }
+    return cfg->sweep_len > 0 ? 0 : -1;
+}
+
+void print_usage(const char *prog_name) {
+    printf("Utilisation : %s [options]\n", prog_name);
+    printf("Options :\n");
+    printf("  -d <device>   périphérique (défaut : %s, /dev/timeotp0 accepte seulement get)\n", DEFAULT_DEVICE);
+    printf("  -t <n,...>    nombre de workers, une liste lance un balayage de contention (défaut : 1)\n");
+    printf("  -P            workers en processus (fork) au lieu de threads\n");
+    printf("  -n <ops>      opérations par worker (défaut : 10000)\n");
+    printf("  -m <mix>      répartition des opérations (défaut : get=100)\n");
+    printf("  -p <taille>   mots de passe pré-remplis avant la mesure (défaut : 100)\n");
+    printf("  -b <taille>   opérations par échantillon de latence (défaut : 1)\n");
+    printf("  -r <n>        chaque worker réserve n entrées du pool pour ses get (défaut : 0)\n");
+    printf("Exemples :\n");
+    printf("  %s -t 1,2,4,8,16 -m get=70,add=10,del=10,list=10 -p 1000\n", prog_name);
+    printf("  %s -t 1,2,4,8,16 -p 1000 -r 50\n", prog_name);
+    printf("  %s -d /dev/timeotp0 -t 4 -n 50000\n", prog_name);
+}
+
+int main(int argc, char *argv[]) {
+    struct bench_config cfg = {
+        .device = DEFAULT_DEVICE,
+        .sweep = { 1 },
+        .sweep_len = 1,
+        .ops = 10000,
+        .batch = 1,
+        .pool_size = 100,
+        .mix = { [OP_GET] = 100 },
+        .mix_total = 100,
+    };
+    int ret = EXIT_SUCCESS;
+    int opt, i;
+
+    while ((opt = getopt(argc, argv, "d:t:Pn:m:p:b:r:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                cfg.device = optarg;
+                break;
+            case 't':
+                if (parse_sweep(&cfg, optarg) < 0) {
+                    fprintf(stderr, "Liste de workers invalide (1 à 1024, au plus %d valeurs).\n", MAX_SWEEP);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'P':
+                cfg.use_processes = 1;
+                break;
+            case 'n':
+                cfg.ops = atol(optarg);
+                break;
+            case 'm':
+                if (parse_mix(&cfg, optarg) < 0) {
+                    fprintf(stderr, "Répartition invalide, exemple : get=70,add=10,del=10,list=10\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'p':
+                cfg.pool_size = atoi(optarg);
+                break;
+            case 'b':
+                cfg.batch = atoi(optarg);
+                break;
+            case 'r':
+                cfg.reserve = atoi(optarg);
+                break;
+            default:
+                print_usage(argv[0]);
+                return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (cfg.ops <= 0 || cfg.batch <= 0 || cfg.pool_size < 0 || cfg.reserve < 0 || cfg.ops < cfg.batch) {
+        fprintf(stderr, "Paramètres invalides : -n >= -b > 0, -p >= 0 et -r >= 0 requis.\n");
+        return EXIT_FAILURE;
+    }
+
+    cfg.timeotp = strstr(cfg.device, "timeotp") != NULL;
+    if (cfg.timeotp) {
+        // mêmes numéros d'ioctl : ADD/DEL modifieraient la clé et la durée du TOTP
+        if (cfg.mix[OP_ADD] || cfg.mix[OP_DEL] || cfg.mix[OP_LIST]) {
+            fprintf(stderr, "Erreur : %s ne supporte que l'opération get.\n", cfg.device);
+            return EXIT_FAILURE;
+        }
+        cfg.pool_size = 0;
+        cfg.reserve = 0;
+    }
+
+    if (cfg.pool_size > 0 && fill_pool(&cfg, OTP_IOC_ADD) < 0)
+        return EXIT_FAILURE;
+
+    printf("device=%s workers=%s ops/worker=%ld batch=%d pool=%d reserve=%d\n", cfg.device,
+           cfg.use_processes ? "processus" : "threads", cfg.ops, cfg.batch, cfg.pool_size, cfg.reserve);
+    printf("%-8s %12s %10s %10s %10s %8s\n", "workers", "ops/s", "p50(us)", "p99(us)", "p999(us)", "erreurs");
+
+    for (i = 0; i < cfg.sweep_len; i++) {
+        if (run_bench(&cfg, cfg.sweep[i]) < 0) {
+            ret = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    if (cfg.pool_size > 0)
+        fill_pool(&cfg, OTP_IOC_DEL);
+
+    return ret;
+}